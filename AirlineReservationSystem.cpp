@@ -6,6 +6,31 @@
 #include <iomanip>
 #include <cstdlib>
 #include <limits> // For input validation
+#include <algorithm>
+#include <ctime>
+#include <unordered_map>
+#include <map>
+#include <cctype>
+#include <list>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <queue>
+#include <string_view>
+#include <cstdio>
+#include <filesystem>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 using namespace std;
 
 // Color codes
@@ -68,6 +93,417 @@ double getDouble(const string &prompt, double minVal = numeric_limits<double>::l
     }
 }
 
+// Reads a whole file with one allocation and returns views of its lines.
+// The views point into `buffer`, so it must outlive them.
+bool readLines(const string &path, string &buffer, vector<string_view> &lines)
+{
+    ifstream fin(path, ios::binary);
+    if (!fin.is_open())
+        return false;
+    fin.seekg(0, ios::end);
+    streamoff size = fin.tellg();
+    fin.seekg(0, ios::beg);
+    buffer.resize(size > 0 ? (size_t)size : 0);
+    fin.read(&buffer[0], buffer.size());
+    buffer.resize((size_t)fin.gcount());
+    fin.close();
+
+    lines.clear();
+    lines.reserve(count(buffer.begin(), buffer.end(), '\n') + 1);
+    string_view rest(buffer);
+    while (!rest.empty())
+    {
+        size_t end = rest.find('\n');
+        string_view line = rest.substr(0, end);
+        if (!line.empty() && line.back() == '\r') // files written in text mode on Windows
+            line.remove_suffix(1);
+        lines.push_back(line);
+        if (end == string_view::npos)
+            break;
+        rest.remove_prefix(end + 1);
+    }
+    return true;
+}
+
+// Splits a CSV line into views, reusing the capacity of `tokens` across calls
+void splitCSV(string_view line, vector<string_view> &tokens)
+{
+    tokens.clear();
+    while (true)
+    {
+        size_t comma = line.find(',');
+        tokens.push_back(line.substr(0, comma));
+        if (comma == string_view::npos)
+            break;
+        line.remove_prefix(comma + 1);
+    }
+}
+
+// Parses a non-negative decimal field; false for anything else
+bool parseCount(string_view text, long long &value)
+{
+    if (text.empty() || text.size() > 18)
+        return false;
+    value = 0;
+    for (char c : text)
+    {
+        if (c < '0' || c > '9')
+            return false;
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+// Monotonic arena for the strings of bulk-loaded records. A loaded file is
+// kept whole so its records can point straight into it; strings created
+// later are copied into large blocks. Nothing is freed until the arena is.
+class StringArena
+{
+    vector<unique_ptr<string>> files;
+    vector<unique_ptr<char[]>> blocks;
+    size_t blockUsed = 0;
+    size_t blockSize = 0;
+
+public:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    // Buffer to read a whole file into; it stays put for the arena's lifetime
+    string &fileBuffer()
+    {
+        files.push_back(make_unique<string>());
+        return *files.back();
+    }
+
+    string_view store(string_view text)
+    {
+        if (blocks.empty() || blockUsed + text.size() > blockSize)
+        {
+            blockSize = max(BLOCK_SIZE, text.size());
+            blocks.push_back(unique_ptr<char[]>(new char[blockSize]));
+            blockUsed = 0;
+        }
+        char *dest = blocks.back().get() + blockUsed;
+        copy(text.begin(), text.end(), dest);
+        blockUsed += text.size();
+        return string_view(dest, text.size());
+    }
+};
+
+// Instrumentation: per-operation counters, latency histograms and file I/O
+// byte counters. Build with -DAIRLINE_NO_STATS to compile all of it out.
+enum Operation
+{
+    OP_BOOK_TICKET,
+    OP_SEAT_CHECK,
+    OP_SEARCH_FLIGHTS,
+    OP_LOAD_ADMINS,
+    OP_LOAD_PASSENGERS,
+    OP_LOAD_FLIGHTS,
+    OP_LOAD_BOOKINGS,
+    OP_SAVE_ADMINS,
+    OP_SAVE_PASSENGERS,
+    OP_SAVE_FLIGHTS,
+    OP_SAVE_BOOKINGS,
+    OP_COUNT
+};
+
+const char *const OPERATION_NAMES[OP_COUNT] = {
+    "bookTicket", "isSeatAvailable", "searchFlights",
+    "loadAdmins", "loadPassengers", "loadFlights", "loadBookings",
+    "saveAdmins", "savePassengers", "saveFlights", "saveBookings"};
+
+const int STATS_DUMP_INTERVAL_SECONDS = 60;
+
+#ifndef AIRLINE_NO_STATS
+// Log-linear (HDR-style) histogram of microsecond latencies: every power of
+// two is split into 4 sub-buckets, so any recorded value is within 25%.
+class LatencyHistogram
+{
+    static const int SUB_BUCKETS = 4;
+    static const int BUCKETS = 64 * SUB_BUCKETS;
+    atomic<unsigned long long> counts[BUCKETS];
+    atomic<unsigned long long> total;
+    atomic<unsigned long long> sumMicros;
+    atomic<unsigned long long> maxMicros;
+
+    static int bucketFor(unsigned long long v)
+    {
+        if (v < SUB_BUCKETS)
+            return (int)v;
+        int msb = 63;
+        while (!(v >> msb))
+            msb--;
+        int sub = (int)((v >> (msb - 2)) & (SUB_BUCKETS - 1));
+        return (msb - 1) * SUB_BUCKETS + sub;
+    }
+
+    static unsigned long long bucketUpperBound(int idx)
+    {
+        if (idx < SUB_BUCKETS)
+            return idx;
+        int msb = idx / SUB_BUCKETS + 1;
+        unsigned long long width = 1ULL << (msb - 2);
+        return (SUB_BUCKETS + idx % SUB_BUCKETS) * width + width - 1;
+    }
+
+public:
+    LatencyHistogram() : total(0), sumMicros(0), maxMicros(0)
+    {
+        for (int i = 0; i < BUCKETS; i++)
+            counts[i] = 0;
+    }
+
+    void record(unsigned long long micros)
+    {
+        counts[bucketFor(micros)].fetch_add(1, memory_order_relaxed);
+        total.fetch_add(1, memory_order_relaxed);
+        sumMicros.fetch_add(micros, memory_order_relaxed);
+        unsigned long long prevMax = maxMicros.load(memory_order_relaxed);
+        while (micros > prevMax && !maxMicros.compare_exchange_weak(prevMax, micros, memory_order_relaxed))
+        {
+        }
+    }
+
+    unsigned long long count() const { return total.load(memory_order_relaxed); }
+    unsigned long long max() const { return maxMicros.load(memory_order_relaxed); }
+
+    double mean() const
+    {
+        unsigned long long n = count();
+        return n ? (double)sumMicros.load(memory_order_relaxed) / n : 0.0;
+    }
+
+    // Upper bound of the bucket holding the p-th percentile (p in 0..100)
+    unsigned long long percentile(double p) const
+    {
+        unsigned long long n = count();
+        if (n == 0)
+            return 0;
+        unsigned long long rank = (unsigned long long)(p / 100.0 * n);
+        if (rank >= n)
+            rank = n - 1;
+        unsigned long long seen = 0;
+        for (int i = 0; i < BUCKETS; i++)
+        {
+            seen += counts[i].load(memory_order_relaxed);
+            if (seen > rank)
+                return min(bucketUpperBound(i), max());
+        }
+        return max();
+    }
+};
+
+class Stats
+{
+    LatencyHistogram histograms[OP_COUNT];
+    atomic<unsigned long long> bytesRead;
+    atomic<unsigned long long> bytesWritten;
+    chrono::steady_clock::time_point lastDump;
+    mutex dumpLock; // guards lastDump
+
+public:
+    Stats() : bytesRead(0), bytesWritten(0), lastDump(chrono::steady_clock::now()) {}
+
+    void record(Operation op, unsigned long long micros) { histograms[op].record(micros); }
+    void addRead(size_t n) { bytesRead.fetch_add(n, memory_order_relaxed); }
+    void addWritten(size_t n) { bytesWritten.fetch_add(n, memory_order_relaxed); }
+
+    void report(ostream &out) const
+    {
+        out << left
+            << setw(18) << "Operation"
+            << setw(10) << "Count"
+            << setw(12) << "Mean(us)"
+            << setw(10) << "p50(us)"
+            << setw(10) << "p99(us)"
+            << setw(10) << "Max(us)" << "\n";
+        out << string(70, '=') << "\n";
+        for (int i = 0; i < OP_COUNT; i++)
+        {
+            const LatencyHistogram &h = histograms[i];
+            out << left
+                << setw(18) << OPERATION_NAMES[i]
+                << setw(10) << h.count()
+                << setw(12) << fixed << setprecision(1) << h.mean()
+                << setw(10) << h.percentile(50)
+                << setw(10) << h.percentile(99)
+                << setw(10) << h.max() << "\n";
+        }
+        out << "Bytes read: " << bytesRead.load(memory_order_relaxed)
+            << ", bytes written: " << bytesWritten.load(memory_order_relaxed) << "\n";
+    }
+
+    // Rewrites the dump file at most once per STATS_DUMP_INTERVAL_SECONDS
+    void dumpIfDue(const string &path, bool force = false)
+    {
+        lock_guard<mutex> guard(dumpLock);
+        auto now = chrono::steady_clock::now();
+        if (!force && now - lastDump < chrono::seconds(STATS_DUMP_INTERVAL_SECONDS))
+            return;
+        lastDump = now;
+        ofstream fout(path);
+        report(fout);
+        fout.close();
+    }
+};
+
+// Records the lifetime of the enclosing scope into the operation's histogram
+class ScopedTimer
+{
+    Stats &stats;
+    Operation op;
+    chrono::steady_clock::time_point start;
+
+public:
+    ScopedTimer(Stats &s, Operation o) : stats(s), op(o), start(chrono::steady_clock::now()) {}
+    ~ScopedTimer()
+    {
+        auto elapsed = chrono::steady_clock::now() - start;
+        stats.record(op, chrono::duration_cast<chrono::microseconds>(elapsed).count());
+    }
+};
+
+// Each airline keeps its own Stats member named `stats`
+#define STATS_TIME(op) ScopedTimer statsTimer_(stats, op)
+#define STATS_READ(n) stats.addRead(n)
+#define STATS_WRITTEN(n) stats.addWritten(n)
+#else
+#define STATS_TIME(op)
+#define STATS_READ(n) ((void)(n))
+#define STATS_WRITTEN(n) ((void)(n))
+#endif
+
+// Snapshot files start with a "#snapshot,<record count>,<checksum>" header.
+// They are written to a temp file, synced to disk and renamed into place, so
+// a crash mid-save leaves either the old or the new file, never half of one.
+unsigned int checksum(string_view data, unsigned int hash = 2166136261u) // FNV-1a
+{
+    for (char c : data)
+    {
+        hash ^= (unsigned char)c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Flushes a file's directory entry to disk after it is created or renamed
+void syncDirectory(const string &path)
+{
+#ifndef _WIN32
+    string dir = filesystem::path(path).parent_path().string();
+    int fd = open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        fsync(fd);
+        close(fd);
+    }
+#endif
+}
+
+// `body` holds `count` newline-terminated records. The previous snapshot is
+// kept as path + ".bak" in case this one turns out to be unreadable.
+// Returns the bytes written, or 0 if the save failed.
+size_t writeSnapshot(const string &path, const string &body, size_t count)
+{
+    string tmpPath = path + ".tmp";
+    string header = "#snapshot," + to_string(count) + "," + to_string(checksum(body)) + "\n";
+
+    FILE *f = fopen(tmpPath.c_str(), "wb");
+    bool ok = f != nullptr;
+    if (ok)
+    {
+        ok = fwrite(header.data(), 1, header.size(), f) == header.size() &&
+             fwrite(body.data(), 1, body.size(), f) == body.size() &&
+             fflush(f) == 0;
+#ifdef _WIN32
+        ok = ok && _commit(_fileno(f)) == 0;
+#else
+        ok = ok && fsync(fileno(f)) == 0;
+#endif
+        ok = (fclose(f) == 0) && ok;
+    }
+
+    error_code ec;
+    if (ok && filesystem::exists(path, ec))
+    {
+        // Keep the previous copy as .bak without ever moving `path` away
+        string bakPath = path + ".bak";
+        filesystem::remove(bakPath, ec);
+        filesystem::create_hard_link(path, bakPath, ec);
+        if (ec)
+            filesystem::copy_file(path, bakPath, filesystem::copy_options::overwrite_existing, ec);
+    }
+    if (ok)
+    {
+        filesystem::rename(tmpPath, path, ec);
+        ok = !ec;
+    }
+    if (ok)
+        syncDirectory(path); // make the rename itself durable
+    if (!ok)
+    {
+        filesystem::remove(tmpPath, ec);
+        printColored("Could not save " + path + ", the previous copy was kept.\n", RED);
+        return 0;
+    }
+    return header.size() + body.size();
+}
+
+// Verifies and strips the snapshot header. Files written before snapshots
+// had headers carry none and are accepted as they are.
+bool verifySnapshot(vector<string_view> &lines)
+{
+    if (lines.empty() || lines[0].substr(0, 10) != "#snapshot,")
+        return true;
+
+    vector<string_view> header;
+    splitCSV(lines[0], header);
+    lines.erase(lines.begin());
+    if (header.size() != 3 || header[1] != to_string(lines.size()))
+        return false;
+
+    unsigned int hash = checksum("");
+    for (string_view line : lines)
+        hash = checksum("\n", checksum(line, hash));
+    return header[2] == to_string(hash);
+}
+
+// Loads a snapshot, falling back to the ".bak" copy when the file is missing
+// or fails verification. A damaged file is moved aside to ".corrupt" so the
+// next save does not overwrite the evidence.
+bool loadSnapshot(const string &path, string &buffer, vector<string_view> &lines)
+{
+    if (readLines(path, buffer, lines))
+    {
+        if (verifySnapshot(lines))
+            return true;
+        printColored("Warning: " + path + " is damaged, restoring the previous copy.\n", RED);
+        error_code ec;
+        filesystem::rename(path, path + ".corrupt", ec);
+    }
+    string backup = path + ".bak";
+    if (readLines(backup, buffer, lines) && verifySnapshot(lines))
+        return true;
+    lines.clear();
+    return false;
+}
+
+// Returns today's local date as YYYY-MM-DD, the same format flights use
+string todayDate()
+{
+    // Airlines archive concurrently, so use the reentrant localtime
+    time_t now = time(nullptr);
+    tm local;
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    char buf[11];
+    strftime(buf, sizeof(buf), "%Y-%m-%d", &local);
+    return string(buf);
+}
+
 // Flight class
 class Flight
 {
@@ -79,12 +515,16 @@ public:
     string time;      // HH:MM
     double price;
     int totalSeats;
+    int overbookLimit; // extra confirmed tickets allowed beyond totalSeats
+    int originId = -1; // interned city IDs, filled in by the city index
+    int destId = -1;
 
-    Flight() {}
-    Flight(string fn, string org, string dest, string d, string t, double p, int seats)
-        : flightNumber(fn), origin(org), destination(dest), date(d), time(t), price(p), totalSeats(seats) {}
+    Flight() : price(0), totalSeats(0), overbookLimit(0) {}
+    Flight(string fn, string org, string dest, string d, string t, double p, int seats, int overbook = 0)
+        : flightNumber(fn), origin(org), destination(dest), date(d), time(t), price(p), totalSeats(seats), overbookLimit(overbook) {}
 
-    void display() const
+    // seatsLeft replaces the total seat count when given (search results)
+    void display(int seatsLeft = -1) const
     {
         cout << left
              << setw(15) << flightNumber
@@ -93,11 +533,11 @@ public:
              << setw(15) << date
              << setw(10) << time
              << setw(10) << fixed << setprecision(2) << price
-             << setw(10) << totalSeats
+             << setw(10) << (seatsLeft >= 0 ? seatsLeft : totalSeats)
              << "\n";
     }
 
-    static void printHeader()
+    static void printHeader(bool seatsLeft = false)
     {
         cout << BOLD << CYAN;
         cout << left
@@ -107,7 +547,7 @@ public:
              << setw(15) << "Date"
              << setw(10) << "Time"
              << setw(10) << "Price"
-             << setw(10) << "Seats"
+             << setw(10) << (seatsLeft ? "Seats Left" : "Seats")
              << RESET << "\n";
         cout << string(90, '=') << "\n";
     }
@@ -116,57 +556,64 @@ public:
     {
         ostringstream oss;
         oss << flightNumber << "," << origin << "," << destination << "," << date << ","
-            << time << "," << price << "," << totalSeats;
+            << time << "," << price << "," << totalSeats << "," << overbookLimit;
         return oss.str();
     }
 
     static Flight fromCSV(const string &line)
     {
-        istringstream iss(line);
-        string token;
-        vector<string> tokens;
-        while (getline(iss, token, ','))
-            tokens.push_back(token);
-        if (tokens.size() != 7)
+        vector<string_view> tokens;
+        splitCSV(line, tokens);
+        return fromTokens(tokens);
+    }
+
+    static Flight fromTokens(const vector<string_view> &tokens)
+    {
+        // Older files have no overbooking column
+        if (tokens.size() != 7 && tokens.size() != 8)
             return Flight();
-        return Flight(tokens[0], tokens[1], tokens[2], tokens[3], tokens[4],
-                      stod(tokens[5]), stoi(tokens[6]));
+        return Flight(string(tokens[0]), string(tokens[1]), string(tokens[2]), string(tokens[3]), string(tokens[4]),
+                      stod(string(tokens[5])), stoi(string(tokens[6])), tokens.size() == 8 ? stoi(string(tokens[7])) : 0);
     }
 };
 
-// Booking class
+// Booking class. The string fields are views into a StringArena owned by
+// whoever holds the booking, so bookings are cheap to copy and load.
 class Booking
 {
 public:
-    string bookingID;
-    string passengerUsername;
-    string flightNumber;
+    string_view bookingID;
+    string_view passengerUsername;
+    string_view flightNumber;
     int seatNumber;
     bool cancelled;
 
     Booking() : seatNumber(0), cancelled(false) {}
-    Booking(string bID, string pUser, string fNum, int seat)
+    Booking(string_view bID, string_view pUser, string_view fNum, int seat)
         : bookingID(bID), passengerUsername(pUser), flightNumber(fNum), seatNumber(seat), cancelled(false) {}
 
     string toCSV() const
     {
-        return bookingID + "," + passengerUsername + "," + flightNumber + "," + to_string(seatNumber) + "," + (cancelled ? "1" : "0");
+        return string(bookingID) + "," + string(passengerUsername) + "," + string(flightNumber) + "," + to_string(seatNumber) + "," + (cancelled ? "1" : "0");
+    }
+
+    // The booking points into `line`, which must outlive it
+    static Booking fromCSV(string_view line)
+    {
+        vector<string_view> tokens;
+        splitCSV(line, tokens);
+        return fromTokens(tokens);
     }
 
-    static Booking fromCSV(const string &line)
+    static Booking fromTokens(const vector<string_view> &tokens)
     {
-        istringstream iss(line);
-        vector<string> tokens;
-        string token;
-        while (getline(iss, token, ','))
-            tokens.push_back(token);
         if (tokens.size() != 5)
             return Booking();
         Booking b;
         b.bookingID = tokens[0];
         b.passengerUsername = tokens[1];
         b.flightNumber = tokens[2];
-        b.seatNumber = stoi(tokens[3]);
+        b.seatNumber = stoi(string(tokens[3]));
         b.cancelled = (tokens[4] == "1");
         return b;
     }
@@ -176,7 +623,7 @@ public:
         cout << left
              << setw(25) << bookingID
              << setw(20) << flightNumber
-             << setw(8) << seatNumber;
+             << setw(8) << (seatNumber > 0 ? to_string(seatNumber) : "TBA");
         if (cancelled)
             printColored(string(10, ' ') + "Cancelled\n", RED);
         else
@@ -196,264 +643,1466 @@ public:
     }
 };
 
-// User classes
-class User
+// Waitlist entry for a sold-out flight
+class WaitlistEntry
 {
-protected:
-    string username;
-    string password;
-
 public:
-    User() {}
-    User(string u, string p) : username(u), password(p) {}
-    virtual bool login(const string &u, const string &p) = 0;
-    string getUsername() const { return username; }
-    virtual ~User() {}
-    string getPassword() const { return password; }
+    string passengerUsername;
+    string flightNumber;
+    int fareClass; // 1 = Economy, 2 = Business, 3 = First
+    long long requestSeq;
+
+    WaitlistEntry() : fareClass(1), requestSeq(0) {}
+    WaitlistEntry(string pUser, string fNum, int fare, long long seq)
+        : passengerUsername(pUser), flightNumber(fNum), fareClass(fare), requestSeq(seq) {}
+
+    // priority_queue pops the largest entry: higher fare class first, then
+    // whoever asked earliest
+    bool operator<(const WaitlistEntry &other) const
+    {
+        if (fareClass != other.fareClass)
+            return fareClass < other.fareClass;
+        return requestSeq > other.requestSeq;
+    }
+
+    string toCSV() const
+    {
+        return passengerUsername + "," + flightNumber + "," + to_string(fareClass) + "," + to_string(requestSeq);
+    }
+
+    static WaitlistEntry fromTokens(const vector<string_view> &tokens)
+    {
+        if (tokens.size() != 4)
+            return WaitlistEntry();
+        return WaitlistEntry(string(tokens[0]), string(tokens[1]), stoi(string(tokens[2])), stoll(string(tokens[3])));
+    }
 };
 
-class Passenger : public User
+// Live seat state of one flight, kept in step with the active bookings
+struct SeatInventory
 {
-public:
-    Passenger() {}
-    Passenger(string u, string p) : User(u, p) {}
-    bool login(const string &u, const string &p) override
+    vector<char> taken;     // 1-based seat numbers, index 0 unused
+    int active = 0;         // live availability counter: active bookings incl. overbooked
+    list<string> unseated;  // overbooked booking IDs, first come first seated
+    unordered_map<string, list<string>::iterator> unseatedPos; // booking ID -> its place in unseated
+    unordered_map<int, long long> held; // seat -> ID of the checkout hold on it
+
+    void addUnseated(const string &bookingID)
     {
-        return (u == username && p == password);
+        unseated.push_back(bookingID);
+        unseatedPos[bookingID] = prev(unseated.end());
+    }
+
+    void removeUnseated(const string &bookingID)
+    {
+        auto it = unseatedPos.find(bookingID);
+        if (it == unseatedPos.end())
+            return;
+        unseated.erase(it->second);
+        unseatedPos.erase(it);
     }
 };
 
-class Admin : public User
+// Temporary hold on a seat while checkout completes
+struct SeatHold
+{
+    string flightNumber;
+    int seatNumber;
+    string passengerUsername;
+};
+
+// Hierarchical timer wheel with one-second resolution: 60 second slots,
+// 60 minute slots and 24 hour slots. A timer sits in the coarsest level
+// that fits its delay and cascades down as the wheel turns, so scheduling
+// is O(1) and each timer is touched at most three times before it fires.
+class TimerWheel
 {
+    struct Timer
+    {
+        long long id;
+        long long expiresAt;
+    };
+
+    static const int LEVELS = 3;
+    const int slotCount[LEVELS] = {60, 60, 24};
+    const long long slotSpan[LEVELS] = {1, 60, 3600};
+    vector<Timer> slots[LEVELS][60];
+    long long now = 0;
+    size_t pending = 0;
+
+    void insert(const Timer &t)
+    {
+        long long delay = t.expiresAt - now;
+        for (int level = 0; level < LEVELS; level++)
+        {
+            if (delay < slotSpan[level] * slotCount[level] || level == LEVELS - 1)
+            {
+                long long tick = min(t.expiresAt, now + slotSpan[level] * slotCount[level] - 1);
+                slots[level][(tick / slotSpan[level]) % slotCount[level]].push_back(t);
+                return;
+            }
+        }
+    }
+
+    void cascade(int level)
+    {
+        vector<Timer> moving;
+        moving.swap(slots[level][(now / slotSpan[level]) % slotCount[level]]);
+        for (const auto &t : moving)
+            insert(t);
+    }
+
 public:
-    Admin() {}
-    Admin(string u, string p) : User(u, p) {}
-    bool login(const string &u, const string &p) override
+    void schedule(long long id, long long delaySeconds)
     {
-        return (u == username && p == password);
+        insert(Timer{id, now + max(1LL, delaySeconds)});
+        pending++;
+    }
+
+    // Turns the wheel forward to `target` seconds and collects expired IDs
+    void advanceTo(long long target, vector<long long> &expired)
+    {
+        if (pending == 0 && target > now)
+            now = target;
+        while (now < target)
+        {
+            now++;
+            if (now % slotSpan[2] == 0)
+                cascade(2);
+            if (now % slotSpan[1] == 0)
+                cascade(1);
+
+            vector<Timer> &slot = slots[0][now % slotCount[0]];
+            for (size_t i = 0; i < slot.size();)
+            {
+                if (slot[i].expiresAt <= now)
+                {
+                    expired.push_back(slot[i].id);
+                    slot[i] = slot.back();
+                    slot.pop_back();
+                    pending--;
+                }
+                else
+                {
+                    i++;
+                }
+            }
+        }
     }
 };
 
-// AirlineSystem class
-class AirlineSystem
+// IATA codes for the airports we commonly fly to; cities not listed here can
+// still be searched by name
+const pair<const char *, const char *> AIRPORT_CODES[] = {
+    {"Lahore", "LHE"}, {"Karachi", "KHI"}, {"Islamabad", "ISB"}, {"Peshawar", "PEW"},
+    {"Quetta", "UET"}, {"Multan", "MUX"}, {"Faisalabad", "LYP"}, {"Sialkot", "SKT"},
+    {"Dubai", "DXB"}, {"Abu Dhabi", "AUH"}, {"Sharjah", "SHJ"}, {"Doha", "DOH"},
+    {"Jeddah", "JED"}, {"Riyadh", "RUH"}, {"Muscat", "MCT"}, {"Istanbul", "IST"},
+    {"London", "LHR"}, {"Manchester", "MAN"}, {"Paris", "CDG"}, {"Toronto", "YYZ"},
+    {"New York", "JFK"}, {"Beijing", "PEK"}, {"Kuala Lumpur", "KUL"}, {"Bangkok", "BKK"}};
+
+// Dictionary of the cities served by the loaded flights. Names and IATA
+// codes are normalised and interned to integer city IDs, then indexed in a
+// trie for prefix autocomplete and a trigram index for typo-tolerant lookup.
+class CityIndex
 {
-    vector<Passenger> passengers;
-    vector<Admin> admins;
-    vector<Flight> flights;
-    vector<Booking> bookings;
+    struct TrieNode
+    {
+        map<char, int> next;
+        vector<int> cityIds; // cities whose name or code ends at this node
+    };
+
+    vector<TrieNode> trie = vector<TrieNode>(1);            // node 0 is the root
+    vector<string> terms;                                   // normalised names and codes
+    vector<int> termCity;                                   // term -> city ID
+    unordered_map<string, int> termIds;                     // normalised term -> term index
+    unordered_map<string, vector<int>> trigrams;            // trigram -> term indexes
+    vector<string> names;                                   // city ID -> display name
+
+    void addTerm(const string &term, int cityId)
+    {
+        if (term.empty() || termIds.count(term))
+            return;
+        int termId = terms.size();
+        terms.push_back(term);
+        termCity.push_back(cityId);
+        termIds[term] = termId;
 
-    const string adminsFile = "admins.txt";
-    const string passengersFile = "passengers.txt";
-    const string flightsFile = "flights.txt";
-    const string bookingsFile = "bookings.txt";
+        int node = 0;
+        for (char c : term)
+        {
+            auto it = trie[node].next.find(c);
+            if (it == trie[node].next.end())
+            {
+                trie.push_back(TrieNode());
+                it = trie[node].next.emplace(c, (int)trie.size() - 1).first;
+            }
+            node = it->second;
+        }
+        trie[node].cityIds.push_back(cityId);
 
-    Passenger *findPassenger(const string &uname)
+        string padded = "$" + term + "$";
+        for (size_t i = 0; i + 3 <= padded.size(); i++)
+        {
+            vector<int> &posting = trigrams[padded.substr(i, 3)];
+            if (posting.empty() || posting.back() != termId)
+                posting.push_back(termId);
+        }
+    }
+
+    static int editDistance(const string &a, const string &b)
     {
-        for (int i = 0; i < passengers.size(); i++)
+        vector<int> row(b.size() + 1);
+        for (size_t j = 0; j <= b.size(); j++)
+            row[j] = j;
+        for (size_t i = 1; i <= a.size(); i++)
         {
-            if (passengers[i].getUsername() == uname)
+            int diag = row[0];
+            row[0] = i;
+            for (size_t j = 1; j <= b.size(); j++)
             {
-                return &passengers[i];
+                int above = row[j];
+                row[j] = min({row[j] + 1, row[j - 1] + 1, diag + (a[i - 1] == b[j - 1] ? 0 : 1)});
+                diag = above;
+            }
+        }
+        return row[b.size()];
+    }
+
+    static void addUnique(vector<int> &ids, int id)
+    {
+        if (find(ids.begin(), ids.end(), id) == ids.end())
+            ids.push_back(id);
+    }
+
+public:
+    static const int MAX_TYPOS = 2;
+
+    // Lowercases, trims and collapses inner whitespace
+    static string normalize(const string &s)
+    {
+        string out;
+        bool space = false;
+        for (char c : s)
+        {
+            if (isspace((unsigned char)c))
+            {
+                space = !out.empty();
+                continue;
             }
+            if (space)
+                out += ' ';
+            space = false;
+            out += (char)tolower((unsigned char)c);
+        }
+        return out;
+    }
+
+    void clear()
+    {
+        *this = CityIndex();
+    }
+
+    // Returns the city ID for a name, adding the city (and its IATA code)
+    // the first time it is seen
+    int intern(const string &name)
+    {
+        string key = normalize(name);
+        auto it = termIds.find(key);
+        if (it != termIds.end())
+            return termCity[it->second];
+
+        int cityId = names.size();
+        names.push_back(name);
+        addTerm(key, cityId);
+        for (const auto &airport : AIRPORT_CODES)
+        {
+            if (normalize(airport.first) == key)
+                addTerm(normalize(airport.second), cityId);
+        }
+        return cityId;
+    }
+
+    const string &name(int cityId) const { return names[cityId]; }
+
+    // Cities whose name or code starts with `prefix`, at most `limit` of them
+    vector<int> complete(const string &prefix, size_t limit) const
+    {
+        vector<int> result;
+        int node = 0;
+        for (char c : normalize(prefix))
+        {
+            auto it = trie[node].next.find(c);
+            if (it == trie[node].next.end())
+                return result;
+            node = it->second;
+        }
+
+        vector<int> stack(1, node);
+        while (!stack.empty() && result.size() < limit)
+        {
+            const TrieNode &n = trie[stack.back()];
+            stack.pop_back();
+            for (int id : n.cityIds)
+                addUnique(result, id);
+            for (auto it = n.next.rbegin(); it != n.next.rend(); ++it)
+                stack.push_back(it->second);
+        }
+        if (result.size() > limit)
+            result.resize(limit);
+        return result;
+    }
+
+    // Cities within MAX_TYPOS edits of `query`, closest first. Only terms
+    // sharing a trigram with the query are compared.
+    vector<int> fuzzy(const string &query, size_t limit) const
+    {
+        string key = normalize(query);
+        string padded = "$" + key + "$";
+        unordered_map<int, int> shared;
+        for (size_t i = 0; i + 3 <= padded.size(); i++)
+        {
+            auto it = trigrams.find(padded.substr(i, 3));
+            if (it == trigrams.end())
+                continue;
+            for (int termId : it->second)
+                shared[termId]++;
+        }
+
+        vector<pair<int, int>> scored; // (distance, city ID)
+        for (const auto &candidate : shared)
+        {
+            int distance = editDistance(key, terms[candidate.first]);
+            if (distance <= MAX_TYPOS)
+                scored.push_back(make_pair(distance, termCity[candidate.first]));
+        }
+        sort(scored.begin(), scored.end());
+
+        vector<int> result;
+        for (const auto &s : scored)
+        {
+            if (result.size() >= limit)
+                break;
+            addUnique(result, s.second);
+        }
+        return result;
+    }
+
+    // Resolves free text to a single city ID: exact name or code, then a
+    // unique prefix, then a unique closest typo match. Returns -1 with
+    // `suggestions` filled in when the input is ambiguous or unknown.
+    int resolve(const string &query, vector<int> &suggestions) const
+    {
+        suggestions.clear();
+        auto exact = termIds.find(normalize(query));
+        if (exact != termIds.end())
+            return termCity[exact->second];
+
+        suggestions = complete(query, 5);
+        if (suggestions.size() == 1)
+            return suggestions[0];
+        if (!suggestions.empty())
+            return -1;
+
+        suggestions = fuzzy(query, 5);
+        if (suggestions.size() == 1)
+            return suggestions[0];
+        return -1;
+    }
+};
+
+// Search results for one route/date query, with seats left at search time
+struct SearchResult
+{
+    Flight flight;
+    int seatsLeft;
+};
+
+// Bounded LRU cache of searchFlights results keyed by the normalised query
+// (origin city ID, destination city ID, date; -1 / "" mean "any").
+// Entries are dropped as soon as a flight they could contain is added or
+// removed, or the availability of a flight they list changes.
+class SearchCache
+{
+    struct Entry
+    {
+        string key;
+        int originId;
+        int destId;
+        string date;
+        vector<SearchResult> rows;
+    };
+
+    list<Entry> lru; // most recently used first
+    unordered_map<string, list<Entry>::iterator> entries;
+    unordered_map<string, unordered_set<string>> byFlight; // flightNumber -> keys listing it
+    size_t capacity;
+    unsigned long long hits = 0;
+    unsigned long long misses = 0;
+    unsigned long long invalidations = 0;
+
+    static string makeKey(int originId, int destId, const string &date)
+    {
+        return to_string(originId) + "|" + to_string(destId) + "|" + date;
+    }
+
+    void erase(list<Entry>::iterator it)
+    {
+        for (const auto &row : it->rows)
+        {
+            auto flightKeys = byFlight.find(row.flight.flightNumber);
+            if (flightKeys == byFlight.end())
+                continue;
+            flightKeys->second.erase(it->key);
+            if (flightKeys->second.empty())
+                byFlight.erase(flightKeys);
+        }
+        entries.erase(it->key);
+        lru.erase(it);
+    }
+
+public:
+    SearchCache(size_t cap = 256) : capacity(cap) {}
+
+    const vector<SearchResult> *find(int originId, int destId, const string &date)
+    {
+        auto it = entries.find(makeKey(originId, destId, date));
+        if (it == entries.end())
+        {
+            misses++;
+            return nullptr;
+        }
+        hits++;
+        lru.splice(lru.begin(), lru, it->second);
+        return &it->second->rows;
+    }
+
+    const vector<SearchResult> &store(int originId, int destId, const string &date, const vector<SearchResult> &rows)
+    {
+        string key = makeKey(originId, destId, date);
+        auto existing = entries.find(key);
+        if (existing != entries.end())
+            erase(existing->second);
+        if (lru.size() >= capacity)
+            erase(prev(lru.end()));
+
+        lru.push_front(Entry{key, originId, destId, date, rows});
+        entries[key] = lru.begin();
+        for (const auto &row : rows)
+            byFlight[row.flight.flightNumber].insert(key);
+        return lru.front().rows;
+    }
+
+    // A listed flight was removed or its availability changed
+    void invalidateFlight(const string &flightNumber)
+    {
+        auto flightKeys = byFlight.find(flightNumber);
+        if (flightKeys == byFlight.end())
+            return;
+        vector<string> keys(flightKeys->second.begin(), flightKeys->second.end());
+        for (const auto &key : keys)
+        {
+            auto it = entries.find(key);
+            if (it != entries.end())
+            {
+                erase(it->second);
+                invalidations++;
+            }
+        }
+    }
+
+    // A new flight appeared; drop every cached query it would match
+    void invalidateMatching(const Flight &f)
+    {
+        for (auto it = lru.begin(); it != lru.end();)
+        {
+            auto next = std::next(it);
+            if ((it->originId < 0 || it->originId == f.originId) &&
+                (it->destId < 0 || it->destId == f.destId) &&
+                (it->date.empty() || it->date == f.date))
+            {
+                erase(it);
+                invalidations++;
+            }
+            it = next;
+        }
+    }
+
+    void clear()
+    {
+        lru.clear();
+        entries.clear();
+        byFlight.clear();
+    }
+
+    void report(ostream &out) const
+    {
+        unsigned long long lookups = hits + misses;
+        out << "Search cache: " << lru.size() << "/" << capacity << " entries, "
+            << hits << " hits, " << misses << " misses ("
+            << fixed << setprecision(1) << (lookups ? 100.0 * hits / lookups : 0.0) << "% hit rate), "
+            << invalidations << " invalidations\n";
+    }
+};
+
+// Fixed-size pool of worker threads used for loading and indexing data
+class ThreadPool
+{
+    vector<thread> workers;
+    queue<function<void()>> tasks;
+    mutex lock;
+    condition_variable ready;
+    bool stopping = false;
+
+    void work()
+    {
+        while (true)
+        {
+            function<void()> task;
+            {
+                unique_lock<mutex> guard(lock);
+                ready.wait(guard, [this]() { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty())
+                    return;
+                task = move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t threads)
+    {
+        for (size_t i = 0; i < max<size_t>(threads, 1); i++)
+            workers.push_back(thread(&ThreadPool::work, this));
+    }
+
+    ~ThreadPool()
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        ready.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    size_t size() const { return workers.size(); }
+
+    // Waits for a result, running queued tasks in the meantime
+    template <class T>
+    T await(future<T> &result)
+    {
+        while (result.wait_for(chrono::seconds(0)) != future_status::ready)
+        {
+            function<void()> task;
+            {
+                lock_guard<mutex> guard(lock);
+                if (!tasks.empty())
+                {
+                    task = move(tasks.front());
+                    tasks.pop();
+                }
+            }
+            if (task)
+                task();
+            else
+                result.wait_for(chrono::milliseconds(1));
+        }
+        return result.get();
+    }
+
+    // Queues a task. A task that waits on tasks it submitted must use
+    // await() rather than get(), or it could hold up the worker they need.
+    template <class F>
+    auto submit(F task) -> future<decltype(task())>
+    {
+        auto packaged = make_shared<packaged_task<decltype(task())()>>(move(task));
+        future<decltype(task())> result = packaged->get_future();
+        {
+            lock_guard<mutex> guard(lock);
+            tasks.push([packaged]() { (*packaged)(); });
+        }
+        ready.notify_one();
+        return result;
+    }
+};
+
+// User classes
+class User
+{
+protected:
+    string username;
+    string password;
+
+public:
+    User() {}
+    User(string u, string p) : username(u), password(p) {}
+    virtual bool login(const string &u, const string &p) = 0;
+    string getUsername() const { return username; }
+    virtual ~User() {}
+    string getPassword() const { return password; }
+};
+
+class Passenger : public User
+{
+public:
+    Passenger() {}
+    Passenger(string u, string p) : User(u, p) {}
+    bool login(const string &u, const string &p) override
+    {
+        return (u == username && p == password);
+    }
+};
+
+class Admin : public User
+{
+public:
+    Admin() {}
+    Admin(string u, string p) : User(u, p) {}
+    bool login(const string &u, const string &p) override
+    {
+        return (u == username && p == password);
+    }
+};
+
+// AirlineSystem class
+class AirlineSystem
+{
+    vector<Passenger> passengers;
+    vector<Admin> admins;
+    vector<Flight> flights;
+    vector<Booking> bookings;
+
+    unordered_map<string, SeatInventory> inventory;     // flightNumber -> seat state
+    StringArena bookingStrings; // backs every Booking's string fields
+    unordered_map<string_view, size_t> bookingIndex;         // bookingID -> position in bookings
+    unordered_map<string_view, vector<size_t>> passengerBookings; // username -> positions in bookings
+    unordered_map<string, priority_queue<WaitlistEntry>> waitlists;
+    long long nextWaitlistSeq = 1;
+    long long nextBookingSeq = 1; // booking IDs end in this counter
+    long long archivedBlocks = -1; // last archive block the hot file accounts for, -1 if unknown
+
+    CityIndex cities;
+    SearchCache searchCache;
+#ifndef AIRLINE_NO_STATS
+    Stats stats; // written to this airline's stats.txt
+#endif
+
+    ThreadPool &pool;
+    static const size_t MIN_CHUNK_LINES = 4096; // smaller booking files parse on one thread
+
+    const string dataDir; // this airline's own directory
+
+    unordered_map<long long, SeatHold> holds; // hold ID -> hold
+    TimerWheel holdTimers;
+    chrono::steady_clock::time_point holdClockStart = chrono::steady_clock::now();
+    long long nextHoldId = 1;
+    const int holdMinutes = 10;
+
+    const string adminsFile = dataPath("admins.txt");
+    const string passengersFile = dataPath("passengers.txt");
+    const string flightsFile = dataPath("flights.txt");
+    const string bookingsFile = dataPath("bookings.txt");
+    const string archiveFile = dataPath("bookings_archive.txt");
+    const string waitlistFile = dataPath("waitlist.txt");
+    const string waitlistLogFile = dataPath("waitlist.log");
+    const string statsFile = dataPath("stats.txt");
+
+    string dataPath(const string &name) const
+    {
+        return (filesystem::path(dataDir) / name).string();
+    }
+
+    Passenger *findPassenger(const string &uname)
+    {
+        for (int i = 0; i < passengers.size(); i++)
+        {
+            if (passengers[i].getUsername() == uname)
+            {
+                return &passengers[i];
+            }
+        }
+        return nullptr;
+    }
+
+
+    Admin* findAdmin(const string& uname)
+    {
+        for (int i = 0; i < admins.size(); i++)
+        {
+            if (admins[i].getUsername() == uname)
+            {
+                return &admins[i];
+            }
+        }
+        return nullptr;
+    }
+
+
+    Flight* findFlight(const string& flightNumber)
+{
+    for (int i = 0; i < flights.size(); i++)
+    {
+        if (flights[i].flightNumber == flightNumber)
+        {
+            return &flights[i];
+        }
+    }
+    return nullptr;
+}
+
+
+    void loadAdmins()
+    {
+        STATS_TIME(OP_LOAD_ADMINS);
+        string buffer;
+        vector<string_view> lines;
+        if (!loadSnapshot(adminsFile, buffer, lines))
+        {
+            return;
+        }
+        STATS_READ(buffer.size());
+
+        admins.reserve(admins.size() + lines.size());
+        vector<string_view> tokens;
+        for (string_view line : lines)
+        {
+            splitCSV(line, tokens);
+            if (tokens.size() != 2)
+                continue;
+            admins.push_back(Admin(string(tokens[0]), string(tokens[1])));
+        }
+    }
+
+    void saveAdmins()
+{
+    STATS_TIME(OP_SAVE_ADMINS);
+    string body;
+    for (int i = 0; i < admins.size(); i++)
+    {
+        body += admins[i].getUsername() + "," + admins[i].getPassword() + "\n";
+    }
+    STATS_WRITTEN(writeSnapshot(adminsFile, body, admins.size()));
+}
+
+
+    void firstTimeAdminSetup()
+    {
+        printColored("=== First Time Setup for Admin Account ===\n", YELLOW);
+        string uname, pwd1, pwd2;
+        cout << "Set Admin Username: ";
+        getline(cin, uname);
+
+        while (true)
+        {
+            cout << "Set Admin Password: ";
+            getline(cin, pwd1);
+            cout << "Confirm Admin Password: ";
+            getline(cin, pwd2);
+
+            if (pwd1 == pwd2)
+            {
+                break;
+            }
+            else
+            {
+                printColored("Passwords do not match. Please try again.\n", RED);
+            }
+        }
+        admins.push_back(Admin(uname, pwd1));
+        saveAdmins();
+        printColored("Admin account created successfully! Open the airline again to login.\n", GREEN);
+    }
+
+    void loadPassengers()
+    {
+        STATS_TIME(OP_LOAD_PASSENGERS);
+        string buffer;
+        vector<string_view> lines;
+        if (!loadSnapshot(passengersFile, buffer, lines))
+            return;
+        STATS_READ(buffer.size());
+
+        passengers.reserve(passengers.size() + lines.size());
+        vector<string_view> tokens;
+        for (string_view line : lines)
+        {
+            splitCSV(line, tokens);
+            if (tokens.size() != 2)
+                continue;
+            passengers.push_back(Passenger(string(tokens[0]), string(tokens[1])));
+        }
+    }
+
+    void savePassengers()
+    {
+        STATS_TIME(OP_SAVE_PASSENGERS);
+        string body;
+        for (int i = 0; i < passengers.size(); i++)
+        {
+            body += passengers[i].getUsername() + "," + passengers[i].getPassword() + "\n";
+        }
+        STATS_WRITTEN(writeSnapshot(passengersFile, body, passengers.size()));
+    }
+
+
+    void loadFlights()
+    {
+        STATS_TIME(OP_LOAD_FLIGHTS);
+        string buffer;
+        vector<string_view> lines;
+        if (!loadSnapshot(flightsFile, buffer, lines))
+            return;
+        STATS_READ(buffer.size());
+
+        flights.reserve(flights.size() + lines.size());
+        vector<string_view> tokens;
+        for (string_view line : lines)
+        {
+            splitCSV(line, tokens);
+            Flight f = Flight::fromTokens(tokens);
+            if (!f.flightNumber.empty())
+            {
+                flights.push_back(move(f));
+            }
+        }
+    }
+
+    void saveFlights()
+    {
+        STATS_TIME(OP_SAVE_FLIGHTS);
+        string body;
+        for (int i = 0; i < flights.size(); i++)
+        {
+            body += flights[i].toCSV() + "\n";
+        }
+        STATS_WRITTEN(writeSnapshot(flightsFile, body, flights.size()));
+    }
+
+
+    void loadBookings()
+    {
+        STATS_TIME(OP_LOAD_BOOKINGS);
+        string &buffer = bookingStrings.fileBuffer(); // bookings point into it
+        vector<string_view> lines;
+        if (!loadSnapshot(bookingsFile, buffer, lines))
+            return;
+        STATS_READ(buffer.size());
+
+        // First record: "next,<next booking number>,<last archive block>".
+        // It has too few fields to parse as a booking below.
+        vector<string_view> mark;
+        if (!lines.empty())
+            splitCSV(lines[0], mark);
+        if (mark.size() == 3 && mark[0] == "next")
+        {
+            parseCount(mark[1], nextBookingSeq);
+            parseCount(mark[2], archivedBlocks);
+        }
+
+        // Parse contiguous chunks of the file on the pool, merge in file order
+        size_t chunkCount = min(pool.size(), lines.size() / MIN_CHUNK_LINES + 1);
+        size_t chunkSize = (lines.size() + chunkCount - 1) / chunkCount;
+        vector<future<vector<Booking>>> chunks;
+        for (size_t start = 0; start < lines.size(); start += chunkSize)
+        {
+            size_t end = min(lines.size(), start + chunkSize);
+            chunks.push_back(pool.submit([&lines, start, end]() {
+                vector<Booking> parsed;
+                parsed.reserve(end - start);
+                vector<string_view> tokens;
+                for (size_t i = start; i < end; i++)
+                {
+                    splitCSV(lines[i], tokens);
+                    Booking b = Booking::fromTokens(tokens);
+                    if (!b.bookingID.empty())
+                        parsed.push_back(move(b));
+                }
+                return parsed;
+            }));
+        }
+
+        bookings.reserve(bookings.size() + lines.size());
+        for (auto &chunk : chunks)
+        {
+            vector<Booking> parsed = pool.await(chunk);
+            move(parsed.begin(), parsed.end(), back_inserter(bookings));
+        }
+    }
+
+    void saveBookings()
+    {
+        STATS_TIME(OP_SAVE_BOOKINGS);
+        string body = "next," + to_string(nextBookingSeq) + "," + to_string(archivedBlocks) + "\n";
+        for (int i = 0; i < bookings.size(); i++)
+        {
+            body += bookings[i].toCSV() + "\n";
+        }
+        STATS_WRITTEN(writeSnapshot(bookingsFile, body, bookings.size() + 1));
+    }
+
+    // Cold segment format: each archival pass appends one numbered block
+    //   #block,<count>,<number>
+    //   <shared prefix length>|<suffix>
+    // Lines are sorted and front-coded against the previous line of the block,
+    // so booking IDs like "user_PK301_12" compress down to a few bytes.
+    // The block is synced to disk before the caller saves a hot file without
+    // its bookings. Returns false if it could not be written.
+    bool appendArchiveBlock(vector<Booking> &cold, long long number)
+    {
+        vector<string> lines;
+        for (const auto &b : cold)
+            lines.push_back(b.toCSV());
+        sort(lines.begin(), lines.end());
+
+        string text = "#block," + to_string(lines.size()) + "," + to_string(number) + "\n";
+        string prev;
+        for (const auto &line : lines)
+        {
+            size_t shared = 0;
+            while (shared < prev.size() && shared < line.size() && prev[shared] == line[shared])
+                shared++;
+            text += to_string(shared) + "|" + line.substr(shared) + "\n";
+            prev = line;
+        }
+
+        // A torn last line from an interrupted append must not swallow the header
+        ifstream fin(archiveFile, ios::binary | ios::ate);
+        if (fin.is_open() && fin.tellg() > 0)
+        {
+            fin.seekg(-1, ios::end);
+            if (fin.get() != '\n')
+                text.insert(0, "\n");
+        }
+        fin.close();
+
+        FILE *f = fopen(archiveFile.c_str(), "ab");
+        bool ok = f != nullptr;
+        if (ok)
+        {
+            ok = fwrite(text.data(), 1, text.size(), f) == text.size() && fflush(f) == 0;
+#ifdef _WIN32
+            ok = ok && _commit(_fileno(f)) == 0;
+#else
+            ok = ok && fsync(fileno(f)) == 0;
+#endif
+            ok = (fclose(f) == 0) && ok;
+        }
+        if (!ok)
+        {
+            printColored("Could not append to " + archiveFile + ", bookings stay in the hot file.\n", RED);
+            return false;
+        }
+        syncDirectory(archiveFile); // the first append creates the file
+        STATS_WRITTEN(text.size());
+        return true;
+    }
+
+    // Decodes front-coded archive text back into full CSV lines. Every line
+    // depends on the one before it, so a damaged line makes the rest of its
+    // block unreadable; that remainder is skipped up to the next header.
+    void decodeArchive(istream &in, vector<string> &records)
+    {
+        string line, prev;
+        bool damaged = false;
+        while (getline(in, line))
+        {
+            STATS_READ(line.size() + 1);
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.rfind("#block,", 0) == 0)
+            {
+                prev.clear();
+                damaged = false;
+                continue;
+            }
+            size_t bar = line.find('|');
+            long long shared;
+            if (damaged || bar == string::npos || !parseCount(string_view(line).substr(0, bar), shared) ||
+                shared > (long long)prev.size())
+            {
+                damaged = damaged || !line.empty();
+                continue;
+            }
+            prev = prev.substr(0, shared) + line.substr(bar + 1);
+            records.push_back(prev);
+        }
+    }
+
+    // Decodes the whole cold segment into `arena`; only called on demand
+    // (e.g. from history)
+    vector<Booking> loadArchivedBookings(StringArena &arena)
+    {
+        vector<Booking> archived;
+        ifstream fin(archiveFile);
+        if (!fin.is_open())
+            return archived;
+
+        vector<string> records;
+        decodeArchive(fin, records);
+        fin.close();
+        for (const auto &record : records)
+        {
+            Booking b = Booking::fromCSV(arena.store(record));
+            if (!b.bookingID.empty())
+                archived.push_back(b);
+        }
+        return archived;
+    }
+
+    // Decodes only the final block into `records`, reading the file backwards
+    // from the end until its header turns up. Returns the block's number, or
+    // -1 if there is none or it predates block numbers.
+    long long lastArchiveBlock(vector<string> &records)
+    {
+        ifstream fin(archiveFile, ios::binary);
+        if (!fin.is_open())
+            return -1;
+        fin.seekg(0, ios::end);
+        streamoff size = fin.tellg();
+
+        string tail;
+        for (streamoff window = 64 * 1024;; window *= 2)
+        {
+            streamoff start = max<streamoff>(0, size - window);
+            tail.resize((size_t)(size - start));
+            fin.seekg(start);
+            fin.read(&tail[0], tail.size());
+            size_t header = tail.rfind("\n#block,");
+            if (header != string::npos)
+            {
+                tail.erase(0, header + 1);
+                break;
+            }
+            if (start == 0)
+            {
+                if (tail.rfind("#block,", 0) != 0)
+                    return -1;
+                break;
+            }
+        }
+        fin.close();
+
+        vector<string_view> header;
+        splitCSV(string_view(tail).substr(0, tail.find('\n')), header);
+        long long number = -1;
+        if (header.size() != 3 || !parseCount(header[2], number))
+            number = -1;
+
+        istringstream in(tail);
+        decodeArchive(in, records);
+        return number;
+    }
+
+    // Booking IDs must stay unique across the hot file and the archive.
+    // Files from before the counter was saved seed it from the highest ID
+    // in use anywhere.
+    void seedBookingSeq()
+    {
+        StringArena archived;
+        vector<Booking> all = loadArchivedBookings(archived);
+        all.insert(all.end(), bookings.begin(), bookings.end());
+        for (const auto &b : all)
+        {
+            size_t underscore = b.bookingID.rfind('_');
+            long long n;
+            if (underscore != string_view::npos && parseCount(b.bookingID.substr(underscore + 1), n))
+                nextBookingSeq = max(nextBookingSeq, n + 1);
+        }
+    }
+
+    // The hot file records the last archive block it accounts for. A newer
+    // block on disk was appended by a run that stopped before saving the hot
+    // file, so its bookings are dropped from the hot set, not archived again.
+    // Returns whether the hot set changed.
+    bool reconcileArchive()
+    {
+        vector<string> lastBlock;
+        long long lastNumber = lastArchiveBlock(lastBlock);
+        if (archivedBlocks < 0) // hot file predates the mark
+        {
+            archivedBlocks = max(lastNumber, 0LL);
+            seedBookingSeq();
+            return false;
+        }
+        if (lastNumber <= archivedBlocks)
+            return false;
+
+        unordered_set<string> archivedIDs;
+        for (const auto &record : lastBlock)
+            archivedIDs.insert(record.substr(0, record.find(',')));
+        vector<Booking> hot;
+        for (const auto &b : bookings)
+        {
+            if (!archivedIDs.count(string(b.bookingID)))
+                hot.push_back(b);
+        }
+        bookings.swap(hot);
+        archivedBlocks = lastNumber;
+        return true;
+    }
+
+    // Moves cancelled bookings and bookings for departed flights out of the
+    // in-memory set, so the hot vector only holds upcoming, active bookings
+    void archiveBookings()
+    {
+        bool changed = reconcileArchive();
+
+        unordered_map<string, string> flightDates;
+        for (const auto &f : flights)
+            flightDates[f.flightNumber] = f.date;
+
+        string today = todayDate();
+        vector<Booking> hot, cold;
+        for (const auto &b : bookings)
+        {
+            auto it = flightDates.find(string(b.flightNumber));
+            if (b.cancelled || (it != flightDates.end() && it->second < today))
+                cold.push_back(b);
+            else
+                hot.push_back(b);
         }
-        return nullptr;
+        if (!cold.empty() && appendArchiveBlock(cold, archivedBlocks + 1))
+        {
+            archivedBlocks++;
+            bookings.swap(hot);
+            changed = true;
+        }
+        if (changed)
+            saveBookings();
     }
 
+    void resetInventory(const Flight &f)
+    {
+        SeatInventory &inv = inventory[f.flightNumber];
+        inv.taken.assign(f.totalSeats + 1, 0);
+        inv.active = 0;
+        inv.unseated.clear();
+        inv.unseatedPos.clear();
+    }
 
-    Admin* findAdmin(const string& uname)
+    // Counts an existing active booking in its flight's seat map. One whose
+    // seat is out of range or already taken (e.g. the flight was removed and
+    // added again with fewer seats) becomes seatless and waits for a seat.
+    void placeExistingBooking(SeatInventory &inv, Booking &b)
     {
-        for (int i = 0; i < admins.size(); i++)
+        inv.active++;
+        if (b.seatNumber >= 1 && b.seatNumber < (int)inv.taken.size() && !inv.taken[b.seatNumber])
         {
-            if (admins[i].getUsername() == uname)
-            {
-                return &admins[i];
-            }
+            inv.taken[b.seatNumber] = 1;
+        }
+        else
+        {
+            b.seatNumber = 0;
+            inv.addUnseated(string(b.bookingID));
         }
-        return nullptr;
     }
 
-
-    Flight* findFlight(const string& flightNumber)
-{
-    for (int i = 0; i < flights.size(); i++)
+    // Rebuilds seat maps and availability counters from the hot bookings
+    void buildSeatMaps()
     {
-        if (flights[i].flightNumber == flightNumber)
+        inventory.clear();
+        for (const auto &f : flights)
+            resetInventory(f);
+
+        for (size_t i = 0; i < bookings.size(); i++)
         {
-            return &flights[i];
+            Booking &b = bookings[i];
+            auto it = inventory.find(string(b.flightNumber));
+            if (b.cancelled || it == inventory.end())
+                continue;
+            placeExistingBooking(it->second, b);
         }
     }
-    return nullptr;
-}
 
-
-    void loadAdmins()
+    // Rebuilds the booking ID and passenger -> bookings indexes
+    void buildBookingIndexes()
     {
-        ifstream fin(adminsFile);
-        if (!fin.is_open())
+        bookingIndex.clear();
+        passengerBookings.clear();
+        bookingIndex.reserve(bookings.size());
+        for (size_t i = 0; i < bookings.size(); i++)
         {
-            firstTimeAdminSetup();
-            return;
+            bookingIndex[bookings[i].bookingID] = i;
+            passengerBookings[bookings[i].passengerUsername].push_back(i);
         }
+    }
 
-        string line;
-        bool loadedAny = false;
-        while (getline(fin, line))
+    // Appends a booking and records it in the seat index.
+    // seatNumber 0 marks an overbooked ticket still waiting for a seat.
+    Booking &addBooking(const string &username, const string &flightNumber, int seatNumber)
+    {
+        string bookingID = generateBookingID(username, flightNumber);
+        bookings.push_back(Booking(bookingStrings.store(bookingID), bookingStrings.store(username),
+                                   bookingStrings.store(flightNumber), seatNumber));
+        bookingIndex[bookings.back().bookingID] = bookings.size() - 1;
+        passengerBookings[bookings.back().passengerUsername].push_back(bookings.size() - 1);
+
+        SeatInventory &inv = inventory[flightNumber];
+        inv.active++;
+        if (seatNumber > 0 && seatNumber < (int)inv.taken.size())
         {
-            istringstream iss(line);
-            vector<string> tokens;
-            string token;
-            while (getline(iss, token, ','))
-                tokens.push_back(token);
-
-            if (tokens.size() != 2)
-                continue;
-            admins.push_back(Admin(tokens[0], tokens[1]));
-            loadedAny = true;
+            inv.taken[seatNumber] = 1;
         }
-        fin.close();
-
-        if (!loadedAny)
+        else
         {
-            firstTimeAdminSetup();
+            bookings.back().seatNumber = 0;
+            inv.addUnseated(bookingID);
         }
+        searchCache.invalidateFlight(flightNumber);
+        return bookings.back();
     }
 
-    void saveAdmins()
-{
-    ofstream fout(adminsFile);
-    for (int i = 0; i < admins.size(); i++)
+    void indexFlightCities(Flight &f)
     {
-        fout << admins[i].getUsername() << "," << admins[i].getPassword() << "\n";
+        f.originId = cities.intern(f.origin);
+        f.destId = cities.intern(f.destination);
     }
-    fout.close();
-}
 
+    void rebuildCityIndex()
+    {
+        searchCache.clear(); // cached keys hold city IDs
+        cities.clear();
+        for (auto &f : flights)
+            indexFlightCities(f);
+    }
 
-    void firstTimeAdminSetup()
+    // Resolves what the passenger typed to a city ID, reporting the
+    // correction or the candidates. Blank input means any city (-1).
+    bool resolveCity(const string &input, int &cityId)
     {
-        printColored("=== First Time Setup for Admin Account ===\n", YELLOW);
-        string uname, pwd1, pwd2;
-        cout << "Set Admin Username: ";
-        getline(cin, uname);
+        cityId = -1;
+        if (CityIndex::normalize(input).empty())
+            return true;
 
-        while (true)
+        vector<int> suggestions;
+        cityId = cities.resolve(input, suggestions);
+        if (cityId >= 0)
         {
-            cout << "Set Admin Password: ";
-            getline(cin, pwd1);
-            cout << "Confirm Admin Password: ";
-            getline(cin, pwd2);
+            if (CityIndex::normalize(input) != CityIndex::normalize(cities.name(cityId)))
+                printColored("Showing results for " + cities.name(cityId) + ".\n", CYAN);
+            return true;
+        }
 
-            if (pwd1 == pwd2)
-            {
-                break;
-            }
-            else
-            {
-                printColored("Passwords do not match. Please try again.\n", RED);
-            }
+        if (suggestions.empty())
+        {
+            printColored("No city matches \"" + input + "\".\n", YELLOW);
+            return false;
         }
-        admins.push_back(Admin(uname, pwd1));
-        saveAdmins();
-        printColored("Admin account created successfully! Please restart the program to login.\n", GREEN);
-        exit(0);
+        string list;
+        for (size_t i = 0; i < suggestions.size(); i++)
+            list += (i ? ", " : "") + cities.name(suggestions[i]);
+        printColored("\"" + input + "\" could be: " + list + ". Please be more specific.\n", YELLOW);
+        return false;
     }
 
-    void loadPassengers()
+    void loadWaitlists()
     {
-        ifstream fin(passengersFile);
-        if (!fin.is_open())
-            return;
+        string buffer;
+        vector<string_view> lines;
+        if (loadSnapshot(waitlistFile, buffer, lines))
+            STATS_READ(buffer.size());
 
-        string line;
-        while (getline(fin, line))
+        vector<string_view> tokens;
+        for (string_view line : lines)
         {
-            istringstream iss(line);
-            vector<string> tokens;
-            string token;
-            while (getline(iss, token, ','))
-                tokens.push_back(token);
-
-            if (tokens.size() != 2)
+            splitCSV(line, tokens);
+            if (tokens.size() == 2 && tokens[0] == "next")
+            {
+                nextWaitlistSeq = max(nextWaitlistSeq, stoll(string(tokens[1])));
+                continue;
+            }
+            WaitlistEntry w = WaitlistEntry::fromTokens(tokens);
+            if (w.passengerUsername.empty() || !findFlight(w.flightNumber))
                 continue;
-            passengers.push_back(Passenger(tokens[0], tokens[1]));
+            nextWaitlistSeq = max(nextWaitlistSeq, w.requestSeq + 1);
+            waitlists[w.flightNumber].push(move(w));
         }
-        fin.close();
+
+        if (replayWaitlistLog())
+            saveWaitlists();
     }
 
-    void savePassengers()
+    // Joins and promotions are appended to the log as they happen:
+    //   +,<waitlist entry>      passenger joined
+    //   -,<flight>,<seq>        entry <seq> was promoted off the top
+    // saveWaitlists folds the log into the snapshot and truncates it.
+    void appendWaitlistLog(const string &record)
     {
-        ofstream fout(passengersFile);
-        for (int i = 0; i < passengers.size(); i++)
-        {
-            fout << passengers[i].getUsername() << "," << passengers[i].getPassword() << "\n";
-        }
+        ofstream fout(waitlistLogFile, ios::app);
+        fout << record << "\n";
         fout.close();
+        STATS_WRITTEN(record.size() + 1);
     }
 
-
-    void loadFlights()
+    // Replays the log over the snapshot. Entries numbered below the
+    // snapshot's "next" mark are already in it, and a promotion only pops
+    // when its entry is still on top, so replaying a log that was written
+    // into a snapshot but not yet truncated changes nothing.
+    bool replayWaitlistLog()
     {
-        ifstream fin(flightsFile);
-        if (!fin.is_open())
-            return;
+        string buffer;
+        vector<string_view> lines;
+        if (!readLines(waitlistLogFile, buffer, lines))
+            return false;
+        STATS_READ(buffer.size());
 
-        string line;
-        while (getline(fin, line))
+        long long snapshotNext = nextWaitlistSeq;
+        vector<string_view> tokens;
+        for (string_view line : lines)
         {
-            Flight f = Flight::fromCSV(line);
-            if (!f.flightNumber.empty())
+            splitCSV(line, tokens);
+            if (tokens.size() == 5 && tokens[0] == "+")
+            {
+                WaitlistEntry w = WaitlistEntry::fromTokens(vector<string_view>(tokens.begin() + 1, tokens.end()));
+                if (w.passengerUsername.empty() || w.requestSeq < snapshotNext || !findFlight(w.flightNumber))
+                    continue;
+                nextWaitlistSeq = max(nextWaitlistSeq, w.requestSeq + 1);
+                waitlists[w.flightNumber].push(move(w));
+            }
+            else if (tokens.size() == 3 && tokens[0] == "-")
             {
-                flights.push_back(f);
+                auto wl = waitlists.find(string(tokens[1]));
+                if (wl == waitlists.end() || to_string(wl->second.top().requestSeq) != tokens[2])
+                    continue;
+                wl->second.pop();
+                if (wl->second.empty())
+                    waitlists.erase(wl);
             }
         }
-        fin.close();
+        return !lines.empty();
     }
 
-    void saveFlights()
+    void saveWaitlists()
     {
-        ofstream fout(flightsFile);
-        for (int i = 0; i < flights.size(); i++)
+        string body = "next," + to_string(nextWaitlistSeq) + "\n";
+        size_t count = 1;
+        for (const auto &entry : waitlists)
+        {
+            priority_queue<WaitlistEntry> copy = entry.second;
+            while (!copy.empty())
+            {
+                body += copy.top().toCSV() + "\n";
+                copy.pop();
+                count++;
+            }
+        }
+        size_t written = writeSnapshot(waitlistFile, body, count);
+        STATS_WRITTEN(written);
+        if (written > 0)
         {
-            fout << flights[i].toCSV() << "\n";
+            error_code ec;
+            filesystem::remove(waitlistLogFile, ec);
         }
-        fout.close();
     }
 
-
-    void loadBookings()
+    // Called once per cancellation: the freed seat goes to the oldest
+    // overbooked ticket, then the best waitlisted passenger takes whatever
+    // capacity is left. Each step is O(1) or one O(log n) heap pop.
+    void releaseSeat(const Booking &cancelled)
     {
-        ifstream fin(bookingsFile);
-        if (!fin.is_open())
+        string flightNumber(cancelled.flightNumber);
+        Flight *f = findFlight(flightNumber);
+        auto invIt = inventory.find(flightNumber);
+        if (!f || invIt == inventory.end())
             return;
-
-        string line;
-        while (getline(fin, line))
+        SeatInventory &inv = invIt->second;
+        inv.active--;
+        searchCache.invalidateFlight(flightNumber);
+
+        // The seatless queue, not seatNumber, says whether it held a seat
+        int freeSeat = 0;
+        string bookingID(cancelled.bookingID);
+        if (inv.unseatedPos.count(bookingID))
         {
-            Booking b = Booking::fromCSV(line);
-            if (!b.bookingID.empty())
-                bookings.push_back(b);
+            inv.removeUnseated(bookingID);
         }
-        fin.close();
+        else if (cancelled.seatNumber >= 1 && cancelled.seatNumber < (int)inv.taken.size())
+        {
+            inv.taken[cancelled.seatNumber] = 0;
+            freeSeat = cancelled.seatNumber;
+        }
+        handOffSeat(*f, inv, freeSeat);
     }
 
-    void saveBookings()
+    // Gives capacity that just opened up (a physical seat when freeSeat > 0)
+    // to the oldest seatless ticket, then to the best waitlisted passenger.
+    // Returns whether any booking changed.
+    bool handOffSeat(const Flight &f, SeatInventory &inv, int freeSeat)
     {
-        ofstream fout(bookingsFile);
-        for (int i = 0; i < bookings.size(); i++)
+        bool changed = false;
+        if (freeSeat >= (int)inv.taken.size())
+            freeSeat = 0;
+        if (freeSeat > 0 && !inv.unseated.empty())
         {
-            fout << bookings[i].toCSV() << "\n";
+            Booking &b = bookings[bookingIndex[inv.unseated.front()]];
+            inv.removeUnseated(string(b.bookingID));
+            b.seatNumber = freeSeat;
+            inv.taken[freeSeat] = 1;
+            printColored("Overbooked ticket " + string(b.bookingID) + " has been assigned seat " + to_string(freeSeat) + ".\n", CYAN);
+            freeSeat = 0;
+            changed = true;
         }
-        fout.close();
+
+        auto wl = waitlists.find(f.flightNumber);
+        if (wl == waitlists.end() || wl->second.empty())
+            return changed;
+        if (inv.active + (int)inv.held.size() >= f.totalSeats + f.overbookLimit)
+            return changed;
+
+        WaitlistEntry next = wl->second.top();
+        wl->second.pop();
+        if (wl->second.empty())
+            waitlists.erase(wl);
+        Booking &promoted = addBooking(next.passengerUsername, next.flightNumber, freeSeat);
+        printColored("Waitlisted passenger " + next.passengerUsername + " promoted, booking " + string(promoted.bookingID) + ".\n", CYAN);
+        appendWaitlistLog("-," + next.flightNumber + "," + to_string(next.requestSeq));
+        return true;
+    }
+
+    void joinWaitlist(Passenger *passenger, const Flight &f)
+    {
+        printColored("Flight " + f.flightNumber + " is sold out.\n", YELLOW);
+        cout << "Join the waitlist? (y/n): ";
+        string answer;
+        getline(cin >> ws, answer);
+        if (answer != "y" && answer != "Y")
+            return;
+
+        int fare = getInt("Fare class (1. Economy, 2. Business, 3. First): ", 1, 3);
+        WaitlistEntry entry(passenger->getUsername(), f.flightNumber, fare, nextWaitlistSeq++);
+        waitlists[f.flightNumber].push(entry);
+        appendWaitlistLog("+," + entry.toCSV());
+        printColored("Added to the waitlist. You will be booked automatically when a seat frees up.\n", GREEN);
     }
 
 
 public:
-    AirlineSystem()
+    // Loads everything from `dir`. Safe to run as a task on `workers`.
+    AirlineSystem(ThreadPool &workers, const string &dir = ".") : pool(workers), dataDir(dir)
     {
-        loadAdmins();
-        loadPassengers();
-        loadFlights();
+        // The data files are independent, so they load concurrently; this
+        // thread takes the bookings file and farms its chunks out to the pool
+        future<void> adminsLoaded = pool.submit([this]() { loadAdmins(); });
+        future<void> passengersLoaded = pool.submit([this]() { loadPassengers(); });
+        future<void> flightsLoaded = pool.submit([this]() { loadFlights(); });
         loadBookings();
+        pool.await(adminsLoaded);
+        pool.await(passengersLoaded);
+        pool.await(flightsLoaded);
+        archiveBookings();
+
+        // Each index pass writes only its own structures
+        future<void> seatsBuilt = pool.submit([this]() { buildSeatMaps(); });
+        future<void> bookingsIndexed = pool.submit([this]() { buildBookingIndexes(); });
+        future<void> citiesIndexed = pool.submit([this]() { rebuildCityIndex(); });
+        loadWaitlists();
+        pool.await(seatsBuilt);
+        pool.await(bookingsIndexed);
+        pool.await(citiesIndexed);
     }
 
     ~AirlineSystem()
@@ -462,12 +2111,27 @@ public:
         savePassengers();
         saveFlights();
         saveBookings();
+        saveWaitlists();
+#ifndef AIRLINE_NO_STATS
+        stats.dumpIfDue(statsFile, true);
+#endif
     }
 
     void run()
     {
+        // Interactive, so it waits until the airline is actually opened.
+        // Returns instead of exiting so the engine still saves every airline.
+        if (admins.empty())
+        {
+            firstTimeAdminSetup();
+            return;
+        }
+
         while (true)
         {
+#ifndef AIRLINE_NO_STATS
+            stats.dumpIfDue(statsFile);
+#endif
             printColored("Select Role:\n", YELLOW + BOLD);
             printColored("1. Admin\n2. Passenger\n3. Exit\n", YELLOW);
             int roleChoice = getInt("Enter choice: ", 1, 3);
@@ -482,14 +2146,6 @@ public:
             }
             else
             {
-                cout << R"(           
-                       ______                __   ____           
-                      / ____/___  ____  ____/ /  / __ )__  _____ 
-                     / / __/ __ \/ __ \/ __  /  / __  / / / / _ \
-                    / /_/ / /_/ / /_/ / /_/ /  / /_/ / /_/ /  __/
-                    \____/\____/\____/\__,_/  /_____/\__, /\___/ 
-                                                    /____/                        
-                )" << endl;
                 break;
             }
             cout << "\n";
@@ -527,9 +2183,10 @@ private:
             printColored("1. Add Flight\n", MAGENTA);
             printColored("2. View All Flights\n", MAGENTA);
             printColored("3. Remove Flight\n", MAGENTA);
-            printColored("4. Logout\n", MAGENTA);
+            printColored("4. Stats\n", MAGENTA);
+            printColored("5. Logout\n", MAGENTA);
 
-            int choice = getInt("Enter choice: ", 1, 4);
+            int choice = getInt("Enter choice: ", 1, 5);
 
             if (choice == 1)
             {
@@ -544,6 +2201,10 @@ private:
                 removeFlight();
             }
             else if (choice == 4)
+            {
+                viewStats();
+            }
+            else if (choice == 5)
             {
                 printColored("Logging out from Admin account.\n", CYAN);
                 break;
@@ -551,6 +2212,18 @@ private:
         }
     }
 
+    void viewStats()
+    {
+#ifndef AIRLINE_NO_STATS
+        printColored("\nOperation Stats:\n", CYAN + BOLD);
+        stats.report(cout);
+        stats.dumpIfDue(statsFile, true);
+#else
+        printColored("Stats were compiled out of this build.\n", YELLOW);
+#endif
+        searchCache.report(cout);
+    }
+
     void addFlight()
     {
         cout << "Enter Flight Number: ";
@@ -577,6 +2250,8 @@ private:
 
         int seats = getInt("Enter Total Seats: ", 1);
 
+        int overbook = getInt("Enter Overbooking Allowance (0 for none): ", 0);
+
         for (const auto &f : flights)
         {
             if (f.flightNumber == fn)
@@ -586,7 +2261,23 @@ private:
             }
         }
 
-        flights.push_back(Flight(fn, org, dest, d, t, p, seats));
+        flights.push_back(Flight(fn, org, dest, d, t, p, seats, overbook));
+        resetInventory(flights.back());
+        // Bookings made before the flight was removed still hold seats on it
+        bool reseated = false;
+        SeatInventory &inv = inventory[fn];
+        for (auto &b : bookings)
+        {
+            if (b.cancelled || b.flightNumber != fn)
+                continue;
+            int seat = b.seatNumber;
+            placeExistingBooking(inv, b);
+            reseated = reseated || b.seatNumber != seat;
+        }
+        if (reseated)
+            saveBookings();
+        indexFlightCities(flights.back());
+        searchCache.invalidateMatching(flights.back());
         saveFlights();
         printColored("Flight added successfully.\n", GREEN);
     }
@@ -623,6 +2314,10 @@ private:
         {
             if (it->flightNumber == fn)
             {
+                inventory.erase(fn);
+                searchCache.invalidateFlight(fn);
+                if (waitlists.erase(fn))
+                    saveWaitlists();
                 flights.erase(it);
                 saveFlights();
                 printColored("Flight removed successfully.\n", GREEN);
@@ -708,27 +2403,76 @@ private:
 
     string generateBookingID(const string &username, const string &flightNumber)
     {
-        static int counter = 0;
-        counter++;
-        return username + "_" + flightNumber + "_" + to_string(counter);
+        string id;
+        do
+        {
+            id = username + "_" + flightNumber + "_" + to_string(nextBookingSeq++);
+        } while (bookingIndex.count(id));
+        return id;
     }
 
     bool isSeatAvailable(const string &flightNumber, int seatNumber)
     {
+        STATS_TIME(OP_SEAT_CHECK);
         Flight *f = findFlight(flightNumber);
         if (!f)
             return false;
         if (seatNumber < 1 || seatNumber > f->totalSeats)
             return false;
 
-        for (int i = 0; i < bookings.size(); i++)
-        {
-            if (!bookings[i].cancelled && bookings[i].flightNumber == flightNumber && bookings[i].seatNumber == seatNumber)
-            {
-                return false;
-            }
-        }
-        return true;
+        expireHolds();
+        auto it = inventory.find(flightNumber);
+        return it != inventory.end() && seatNumber < (int)it->second.taken.size() &&
+               !it->second.taken[seatNumber] && !it->second.held.count(seatNumber);
+    }
+
+    long long placeHold(const string &username, const string &flightNumber, int seatNumber)
+    {
+        long long id = nextHoldId++;
+        holds[id] = SeatHold{flightNumber, seatNumber, username};
+        inventory[flightNumber].held[seatNumber] = id;
+        holdTimers.schedule(id, holdMinutes * 60LL);
+        searchCache.invalidateFlight(flightNumber);
+        return id;
+    }
+
+    // Safe to call for holds that already expired or were released; the
+    // timer for a released hold simply finds nothing when it fires.
+    // Unless the holder is about to book the seat (handOff false), the seat
+    // goes through the same handoff as a cancelled one, since a booker may
+    // have been overbooked or waitlisted while it was held.
+    // Returns whether any booking changed.
+    bool releaseHold(long long id, bool handOff = true)
+    {
+        auto it = holds.find(id);
+        if (it == holds.end())
+            return false;
+        SeatHold hold = it->second;
+        holds.erase(it);
+        searchCache.invalidateFlight(hold.flightNumber);
+
+        auto inv = inventory.find(hold.flightNumber);
+        if (inv == inventory.end())
+            return false;
+        auto seat = inv->second.held.find(hold.seatNumber);
+        if (seat == inv->second.held.end() || seat->second != id)
+            return false;
+        inv->second.held.erase(seat);
+
+        Flight *f = findFlight(hold.flightNumber);
+        return handOff && f && handOffSeat(*f, inv->second, hold.seatNumber);
+    }
+
+    void expireHolds()
+    {
+        auto elapsed = chrono::steady_clock::now() - holdClockStart;
+        vector<long long> expired;
+        holdTimers.advanceTo(chrono::duration_cast<chrono::seconds>(elapsed).count(), expired);
+        bool changed = false;
+        for (long long id : expired)
+            changed = releaseHold(id) || changed;
+        if (changed)
+            saveBookings();
     }
 
     void searchFlights()
@@ -743,19 +2487,39 @@ private:
         string date;
         getline(cin >> ws, date);
 
-        bool found = false;
-        for (int i = 0; i < flights.size(); i++)
+        STATS_TIME(OP_SEARCH_FLIGHTS);
+        int originId, destId;
+        if (!resolveCity(origin, originId) || !resolveCity(dest, destId))
+            return;
+        date = CityIndex::normalize(date);
+
+        expireHolds(); // expiring holds invalidates the entries they affect
+        const vector<SearchResult> *rows = searchCache.find(originId, destId, date);
+        if (!rows)
         {
-            if ((origin.empty() || flights[i].origin == origin) &&
-                (dest.empty() || flights[i].destination == dest) &&
-                (date.empty() || flights[i].date == date))
+            vector<SearchResult> matches;
+            for (int i = 0; i < flights.size(); i++)
             {
-                flights[i].display();
-                found = true;
+                if ((originId < 0 || flights[i].originId == originId) &&
+                    (destId < 0 || flights[i].destId == destId) &&
+                    (date.empty() || flights[i].date == date))
+                {
+                    const SeatInventory &inv = inventory[flights[i].flightNumber];
+                    int left = flights[i].totalSeats - inv.active - (int)inv.held.size();
+                    matches.push_back(SearchResult{flights[i], max(left, 0)});
+                }
             }
+            rows = &searchCache.store(originId, destId, date, matches);
         }
-        if (!found)
+
+        if (rows->empty())
+        {
             printColored("No matching flights found.\n", YELLOW);
+            return;
+        }
+        Flight::printHeader(true);
+        for (const auto &row : *rows)
+            row.flight.display(row.seatsLeft);
     }
 
     void bookTicket(Passenger *passenger)
@@ -770,6 +2534,25 @@ private:
             return;
         }
 
+        expireHolds();
+        const SeatInventory &inv = inventory[flightNum];
+        if (inv.active + (int)inv.held.size() >= f->totalSeats)
+        {
+            // Held seats count against the overbooking allowance, as in handOffSeat
+            if (inv.active + (int)inv.held.size() < f->totalSeats + f->overbookLimit)
+            {
+                Booking &b = addBooking(passenger->getUsername(), flightNum, 0);
+                saveBookings();
+                printColored("All seats are taken, but an overbooked ticket was issued. Your Booking ID is: " + string(b.bookingID) + "\n", GREEN);
+                printColored("Your seat will be assigned as soon as one frees up.\n", YELLOW);
+            }
+            else
+            {
+                joinWaitlist(passenger, *f);
+            }
+            return;
+        }
+
         int seatNum = getInt("Enter seat number to book (1 - " + to_string(f->totalSeats) + "): ", 1, f->totalSeats);
 
         if (!isSeatAvailable(flightNum, seatNum))
@@ -778,9 +2561,30 @@ private:
             return;
         }
 
-        string bookingID = generateBookingID(passenger->getUsername(), flightNum);
-        Booking newBooking(bookingID, passenger->getUsername(), flightNum, seatNum);
-        bookings.push_back(newBooking);
+        // Hold the seat so nobody else can take it while payment completes
+        long long holdId = placeHold(passenger->getUsername(), flightNum, seatNum);
+        printColored("Seat " + to_string(seatNum) + " is held for you for " + to_string(holdMinutes) + " minutes.\n", CYAN);
+        cout << "Confirm payment of " << fixed << setprecision(2) << f->price << "? (y/n): ";
+        string answer;
+        getline(cin >> ws, answer);
+
+        STATS_TIME(OP_BOOK_TICKET);
+        expireHolds();
+        if (!holds.count(holdId))
+        {
+            printColored("Your seat hold expired. Please try booking again.\n", RED);
+            return;
+        }
+        if (answer != "y" && answer != "Y")
+        {
+            if (releaseHold(holdId))
+                saveBookings();
+            printColored("Booking abandoned, seat released.\n", YELLOW);
+            return;
+        }
+        releaseHold(holdId, false);
+
+        string bookingID(addBooking(passenger->getUsername(), flightNum, seatNum).bookingID);
         saveBookings();
         printColored("Booking successful! Your Booking ID is: " + bookingID + "\n", GREEN);
     }
@@ -790,7 +2594,19 @@ private:
         printColored("\nYour Bookings:\n", CYAN + BOLD);
         Booking::printHeader();
         bool found = false;
-        for (const auto &b : bookings)
+        auto own = passengerBookings.find(passenger->getUsername());
+        if (own != passengerBookings.end())
+        {
+            for (size_t i : own->second)
+            {
+                bookings[i].display();
+                found = true;
+            }
+        }
+
+        // Past and cancelled bookings live in the cold archive
+        StringArena archived;
+        for (const auto &b : loadArchivedBookings(archived))
         {
             if (b.passengerUsername == passenger->getUsername())
             {
@@ -808,18 +2624,28 @@ private:
         string bookingID;
         getline(cin >> ws, bookingID);
 
-        for (auto &b : bookings)
+        auto pos = bookingIndex.find(bookingID);
+        if (pos != bookingIndex.end() && bookings[pos->second].passengerUsername == passenger->getUsername())
+        {
+            Booking &b = bookings[pos->second];
+            if (b.cancelled)
+            {
+                printColored("Booking already cancelled.\n", YELLOW);
+                return;
+            }
+            b.cancelled = true;
+            printColored("Booking cancelled successfully.\n", GREEN);
+            releaseSeat(b);
+            saveBookings();
+            return;
+        }
+
+        StringArena archived;
+        for (const auto &b : loadArchivedBookings(archived))
         {
             if (b.bookingID == bookingID && b.passengerUsername == passenger->getUsername())
             {
-                if (b.cancelled)
-                {
-                    printColored("Booking already cancelled.\n", YELLOW);
-                    return;
-                }
-                b.cancelled = true;
-                saveBookings();
-                printColored("Booking cancelled successfully.\n", GREEN);
+                printColored("Booking already cancelled or flight has departed.\n", YELLOW);
                 return;
             }
         }
@@ -830,6 +2656,9 @@ private:
     {
         while (true)
         {
+#ifndef AIRLINE_NO_STATS
+            stats.dumpIfDue(statsFile);
+#endif
             printColored("\n--- Passenger Menu ---\n", CYAN + BOLD);
             printColored("1. Search Flights\n", CYAN);
             printColored("2. Book Ticket\n", CYAN);
@@ -869,6 +2698,119 @@ private:
     }
 };
 
+// Hosts the datasets of many airlines in one process. Each airline keeps
+// its own data directory, indexes and snapshot files; all of them share a
+// single thread pool for loading, indexing and saving.
+class AirlineEngine
+{
+    ThreadPool pool; // declared first so it outlives the airlines
+    vector<string> codes;
+    unordered_map<string, unique_ptr<AirlineSystem>> airlines;
+
+public:
+    // The registry lists one "CODE,directory" per line. Without one, the
+    // working directory is served as a single airline, as before.
+    AirlineEngine(const string &registryFile)
+        : pool(thread::hardware_concurrency())
+    {
+        vector<string> dirs;
+        unordered_set<string> dirsInUse; // two airlines must never share files
+        string buffer;
+        vector<string_view> lines, tokens;
+        if (readLines(registryFile, buffer, lines))
+        {
+            for (string_view line : lines)
+            {
+                splitCSV(line, tokens);
+                if (tokens.size() != 2 || tokens[0].empty() || airlines.count(string(tokens[0])))
+                    continue;
+                string dir = tokens[1].empty() ? "." : string(tokens[1]);
+                error_code ec;
+                filesystem::path canonical = filesystem::absolute(dir, ec);
+                filesystem::path resolved = filesystem::weakly_canonical(canonical, ec);
+                if (!ec)
+                    canonical = resolved;
+                canonical = canonical.lexically_normal(); // parts that don't exist yet
+                if (!canonical.has_filename())
+                    canonical = canonical.parent_path(); // trailing separator
+                if (!dirsInUse.insert(canonical.string()).second)
+                {
+                    printColored("Airline " + string(tokens[0]) + " skipped: " + dir + " is already used by another airline.\n", RED);
+                    continue;
+                }
+                codes.push_back(string(tokens[0]));
+                dirs.push_back(dir);
+                airlines[codes.back()] = nullptr;
+            }
+        }
+        if (codes.empty())
+        {
+            codes.push_back("default");
+            dirs.push_back(".");
+        }
+
+        // Every airline loads as its own pool task; their per-file work
+        // lands on the same pool
+        vector<future<unique_ptr<AirlineSystem>>> loading;
+        for (size_t i = 0; i < codes.size(); i++)
+        {
+            error_code ec;
+            filesystem::create_directories(dirs[i], ec);
+            string dir = dirs[i];
+            loading.push_back(pool.submit([this, dir]() {
+                return make_unique<AirlineSystem>(pool, dir);
+            }));
+        }
+        for (size_t i = 0; i < codes.size(); i++)
+            airlines[codes[i]] = pool.await(loading[i]);
+    }
+
+    // Airlines save their snapshots concurrently on shutdown
+    ~AirlineEngine()
+    {
+        vector<future<void>> saving;
+        for (auto &entry : airlines)
+        {
+            unique_ptr<AirlineSystem> *airline = &entry.second;
+            saving.push_back(pool.submit([airline]() { airline->reset(); }));
+        }
+        for (auto &saved : saving)
+            pool.await(saved);
+    }
+
+    void run()
+    {
+        if (codes.size() == 1)
+        {
+            airlines[codes[0]]->run();
+        }
+        else
+        {
+            while (true)
+            {
+                printColored("Select Airline:\n", YELLOW + BOLD);
+                for (size_t i = 0; i < codes.size(); i++)
+                    printColored(to_string(i + 1) + ". " + codes[i] + "\n", YELLOW);
+                printColored(to_string(codes.size() + 1) + ". Exit\n", YELLOW);
+                int choice = getInt("Enter choice: ", 1, codes.size() + 1);
+                if (choice == (int)codes.size() + 1)
+                    break;
+                airlines[codes[choice - 1]]->run();
+                cout << "\n";
+            }
+        }
+
+        cout << R"(           
+                       ______                __   ____           
+                      / ____/___  ____  ____/ /  / __ )__  _____ 
+                     / / __/ __ \/ __ \/ __  /  / __  / / / / _ \
+                    / /_/ / /_/ / /_/ / /_/ /  / /_/ / /_/ /  __/
+                    \____/\____/\____/\__,_/  /_____/\__, /\___/ 
+                                                    /____/                        
+                )" << endl;
+    }
+};
+
 int main()
 {
     system("cls");
@@ -882,7 +2824,7 @@ int main()
                                                                                                        _/ |                      
                                                                                                      /___/                       
     )" << endl;
-    AirlineSystem system;
-    system.run();
+    AirlineEngine engine("airlines.txt");
+    engine.run();
     return 0;
 }
\ No newline at end of file